@@ -18,14 +18,44 @@
 #include <fstream>
 #include <cmath>
 #include <iomanip>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <coroutine>
+#include <memory>
+#include <utility>
+#include <deque>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
 
 // My code is a demonstration piece of a simplified Monopoly-like game.
 // Key points:
 // - No BFS or DFS traversals.
-// - No trading/unmort features ).
+// - No trading features.
 // - Includes recursion (e.g., for rent calculation), hashing, trees, logging, auctions, and property operations like upgrading and mortgaging.
 // - Added a printHelp() function for meaningful instructions.
 // - Added an '(e)' action to end the game prematurely.
+// - All output goes through a buffered Renderer (verbosity levels, fixed refresh rate, detachable).
+// - Long-running mode (--long) with bounded memory: rotating logs, streaming stats, stalemate detection.
+// - Colour groups as bitmasks: monopolies double rent and are required for upgrades.
+// - Decision points are awaitable, so the same game code runs at the console or
+//   in server mode (--server), which hosts many sessions over a local socket.
+//
+// Build: g++ -std=c++20 -O2 -pthread main.cpp   (coroutines need C++20; server mode needs Linux)
 //
 // My code remains console-based and is not a fully accurate Monopoly simulation. 
 // It demonstrates data structure usage and logic integration.
@@ -37,6 +67,146 @@ using namespace std;
 // ----------------------------------------------------------
 class Board; // Forward declaration of Board class
 
+// ----------------------------------------------------------
+// Renderer: presentation layer for all game output.
+// Game code emits events into a frame buffer; a writer thread presents the
+// frame to stdout at a fixed refresh rate, so turns never wait on the terminal.
+// Events above the current verbosity (or while detached) are never formatted.
+// ----------------------------------------------------------
+enum class Verbosity { Quiet = 0, Normal = 1, Verbose = 2 };
+
+class Renderer {
+public:
+    Verbosity verbosity;
+
+    Renderer(Verbosity verbosity = Verbosity::Normal, int refreshMs = 50, bool startAttached = true)
+        : verbosity(verbosity), refreshMs(refreshMs), attached(false), stopping(false),
+          presenting(false), flushRequested(false), droppedEvents(0) {
+        if (startAttached) attach();
+    }
+
+    ~Renderer() {
+        detach();
+    }
+
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+
+    bool isAttached() const {
+        return attached;
+    }
+
+    bool wants(Verbosity level) const {
+        return attached && level <= verbosity;
+    }
+
+    void setRefreshRate(int ms) {
+        refreshMs = max(1, ms);
+    }
+
+    // Format the arguments into the current frame. Events arriving while the
+    // frame is over budget (stdout cannot keep up) are counted and dropped.
+    template <typename... Args>
+    void emit(Verbosity level, const Args&... args) {
+        if (!wants(level)) return;
+        scratch.str("");
+        (scratch << ... << args);
+        lock_guard<mutex> lock(frameMutex);
+        if (frame.size() >= maxFrameBytes) {
+            droppedEvents++;
+            return;
+        }
+        frame += scratch.str();
+    }
+
+    // Prompts are shown at every verbosity and presented immediately, since
+    // the caller is about to block on cin anyway.
+    template <typename... Args>
+    void prompt(const Args&... args) {
+        if (!attached) {
+            (cout << ... << args) << flush;
+            return;
+        }
+        scratch.str("");
+        (scratch << ... << args);
+        {
+            lock_guard<mutex> lock(frameMutex);
+            frame += scratch.str();
+        }
+        sync();
+    }
+
+    // Present the pending frame now and wait until it has reached stdout.
+    void sync() {
+        if (!attached) return;
+        unique_lock<mutex> lock(frameMutex);
+        flushRequested = true;
+        wake.notify_one();
+        drained.wait(lock, [&] { return frame.empty() && !presenting; });
+    }
+
+    void attach() {
+        if (attached) return;
+        stopping = false;
+        attached = true;
+        writer = thread(&Renderer::writerLoop, this);
+    }
+
+    // Flush what has been emitted so far, then stop rendering entirely.
+    void detach() {
+        if (!attached) return;
+        {
+            lock_guard<mutex> lock(frameMutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+        attached = false;
+    }
+
+private:
+    static constexpr size_t maxFrameBytes = 1 << 20;
+
+    atomic<int> refreshMs;
+    bool attached;
+    bool stopping;
+    bool presenting;
+    bool flushRequested;
+    size_t droppedEvents;
+    string frame;
+    string presented;
+    ostringstream scratch;
+    mutex frameMutex;
+    condition_variable wake;
+    condition_variable drained;
+    thread writer;
+
+    void writerLoop() {
+        unique_lock<mutex> lock(frameMutex);
+        while (true) {
+            wake.wait_for(lock, chrono::milliseconds(refreshMs.load()), [&] { return stopping || flushRequested; });
+            flushRequested = false;
+            if (!frame.empty()) {
+                // Swap buffers so emitters keep appending while we write.
+                presented.swap(frame);
+                if (droppedEvents > 0) {
+                    presented += "(" + to_string(droppedEvents) + " updates skipped)\n";
+                    droppedEvents = 0;
+                }
+                presenting = true;
+                lock.unlock();
+                fwrite(presented.data(), 1, presented.size(), stdout);
+                fflush(stdout);
+                presented.clear();
+                lock.lock();
+                presenting = false;
+            }
+            drained.notify_all();
+            if (stopping && frame.empty()) return;
+        }
+    }
+};
+
 // ----------------------------------------------------------
 // Graph structure for board representation 
 // Only stores adjacency and displays connections from a given node.
@@ -49,29 +219,29 @@ struct Graph {
     }
 
     // Display connections from a given node
-    void displayConnectionsFrom(int start) const {
-        cout << "Connections from space " << start << ": ";
+    void displayConnectionsFrom(int start, ostream& out = cout) const {
+        out << "Connections from space " << start << ": ";
         auto it = adjList.find(start);
         if (it != adjList.end()) {
             for (int neighbor : it->second) {
-                cout << neighbor << " ";
+                out << neighbor << " ";
             }
         } else {
-            cout << "(none)";
+            out << "(none)";
         }
-        cout << endl;
+        out << "\n";
     }
 
-    void displayGraph() const {
-        cout << "\n--- Board Graph Structure\n";
+    void displayGraph(ostream& out = cout) const {
+        out << "\n--- Board Graph Structure\n";
         for (const auto& [node, neighbors] : adjList) {
-            cout << "Space " << node << " connects to: ";
+            out << "Space " << node << " connects to: ";
             for (int neighbor : neighbors) {
-                cout << neighbor << " ";
+                out << neighbor << " ";
             }
-            cout << endl;
+            out << "\n";
         }
-        cout << "--- End of Board Graph ---\n";
+        out << "--- End of Board Graph ---\n";
     }
 
     bool isStronglyConnected() const {
@@ -106,11 +276,20 @@ void insert(TreeNode*& root, const string& name, int money) {
 }
 
 // In-order traversal (recursive)
-void inOrderTraversal(TreeNode* root) {
+void inOrderTraversal(TreeNode* root, ostream& out = cout) {
+    if (!root) return;
+    inOrderTraversal(root->left, out);
+    out << root->name << " - Wealth: $" << root->money << "\n";
+    inOrderTraversal(root->right, out);
+}
+
+// Free the whole tree (recursive, post-order)
+void freeTree(TreeNode*& root) {
     if (!root) return;
-    inOrderTraversal(root->left);
-    cout << root->name << " - Wealth: $" << root->money << endl;
-    inOrderTraversal(root->right);
+    freeTree(root->left);
+    freeTree(root->right);
+    delete root;
+    root = nullptr;
 }
 
 // ----------------------------------------------------------
@@ -125,11 +304,46 @@ struct PropertyHash {
 // ----------------------------------------------------------
 // Utility functions: Logging, recursion demos
 // ----------------------------------------------------------
-void logAction(const string& logMessage, const string& logFile = "game_log.txt") {
-    ofstream outFile(logFile, ios::app);
-    outFile << logMessage << endl;
-    outFile.close();
-}
+// Log file that stays open between writes and rotates once it reaches maxBytes:
+// game_log.txt -> game_log.txt.1 -> ... -> game_log.txt.<backups>, oldest dropped.
+// Disk use is bounded by (backups + 1) * maxBytes no matter how long the game runs.
+class LogSink {
+public:
+    string path;
+    size_t maxBytes;
+    int backups;
+
+    LogSink(const string& path = "game_log.txt", size_t maxBytes = 1 << 20, int backups = 3)
+        : path(path), maxBytes(maxBytes), backups(backups), written(0) {}
+
+    void write(const string& logMessage) {
+        if (!out.is_open()) open();
+        out << logMessage << '\n';
+        written += logMessage.size() + 1;
+        if (written >= maxBytes) rotate();
+    }
+
+    void rotate() {
+        out.close();
+        for (int i = backups - 1; i >= 1; --i) {
+            std::rename((path + "." + to_string(i)).c_str(), (path + "." + to_string(i + 1)).c_str());
+        }
+        if (backups > 0) {
+            std::rename(path.c_str(), (path + ".1").c_str());
+        }
+        out.open(path, ios::trunc);
+        written = 0;
+    }
+
+private:
+    ofstream out;
+    size_t written;
+
+    void open() {
+        out.open(path, ios::app);
+        written = (size_t)max<streamoff>(0, out.tellp());
+    }
+};
 
 int factorial(int n) {
     if (n <= 1) return 1;
@@ -160,51 +374,178 @@ public:
     int propertyCost;
     int baseRent;
     int rentMultiplier;
-
-    Settings() : enableLogging(true), enableRandomEvents(true), startingMoney(1500), propertyCost(100), baseRent(50), rentMultiplier(2) {}
-
-    void displaySettings() const {
-        cout << "\n--- Game Settings ---\n";
-        cout << "Logging: " << (enableLogging ? "Enabled" : "Disabled") << endl;
-        cout << "Random Events: " << (enableRandomEvents ? "Enabled" : "Disabled") << endl;
-        cout << "Starting Money: $" << startingMoney << endl;
-        cout << "Property Cost: $" << propertyCost << endl;
-        cout << "Base Rent: $" << baseRent << endl;
-        cout << "Rent Multiplier: " << rentMultiplier << endl;
-        cout << "--- End of Settings ---\n";
+    int upgradeCost;
+    int turnLimit;       // 0 = play until one player remains or a stalemate is detected
+    int stalemateRounds; // Consecutive rounds with an unchanged board state before the game is called
+
+    Settings() : enableLogging(true), enableRandomEvents(true), startingMoney(1500), propertyCost(100), baseRent(50), rentMultiplier(2),
+                 upgradeCost(50), turnLimit(50), stalemateRounds(2500) {}
+
+    void displaySettings(ostream& out = cout) const {
+        out << "\n--- Game Settings ---\n";
+        out << "Logging: " << (enableLogging ? "Enabled" : "Disabled") << "\n";
+        out << "Random Events: " << (enableRandomEvents ? "Enabled" : "Disabled") << "\n";
+        out << "Starting Money: $" << startingMoney << "\n";
+        out << "Property Cost: $" << propertyCost << "\n";
+        out << "Base Rent: $" << baseRent << "\n";
+        out << "Rent Multiplier: " << rentMultiplier << "\n";
+        out << "Upgrade Cost: $" << upgradeCost << "\n";
+        out << "Turn Limit: " << (turnLimit > 0 ? to_string(turnLimit) : "None") << "\n";
+        out << "--- End of Settings ---\n";
     }
 };
 
 // ----------------------------------------------------------
 // Statistics class
+// Streaming aggregates only: nothing here grows with the number of turns.
 // ----------------------------------------------------------
 class Statistics {
 public:
-    int totalTurns;
+    long long totalTurns;
     int totalPropertiesBought;
-    int totalRentsPaid;
+    long long totalRentsPaid;
+    long long totalRentAmount;
+    int largestRent;
+    int totalBankruptcies;
 
-    Statistics() : totalTurns(0), totalPropertiesBought(0), totalRentsPaid(0) {}
+    Statistics() : totalTurns(0), totalPropertiesBought(0), totalRentsPaid(0), totalRentAmount(0), largestRent(0), totalBankruptcies(0) {}
 
     void recordPropertyBought() {
         totalPropertiesBought++;
     }
 
-    void recordRentPaid() {
+    void recordRentPaid(int amount) {
         totalRentsPaid++;
+        totalRentAmount += amount;
+        largestRent = max(largestRent, amount);
+    }
+
+    void recordBankruptcy() {
+        totalBankruptcies++;
     }
 
     void recordTurn() {
         totalTurns++;
     }
 
-    void displayStatistics() const {
-        cout << "\n--- Game Statistics ---\n";
-        cout << "Total Turns: " << totalTurns << endl;
-        cout << "Total Properties Bought: " << totalPropertiesBought << endl;
-        cout << "Total Rents Paid: " << totalRentsPaid << endl;
-        cout << "--- End of Statistics ---\n";
+    double averageRent() const {
+        return totalRentsPaid ? (double)totalRentAmount / totalRentsPaid : 0.0;
+    }
+
+    void displayStatistics(ostream& out = cout) const {
+        out << "\n--- Game Statistics ---\n";
+        out << "Total Turns: " << totalTurns << "\n";
+        out << "Total Properties Bought: " << totalPropertiesBought << "\n";
+        out << "Total Rents Paid: " << totalRentsPaid << "\n";
+        out << "Average Rent: $" << fixed << setprecision(2) << averageRent() << "\n";
+        out << "Largest Rent: $" << largestRent << "\n";
+        out << "Total Bankruptcies: " << totalBankruptcies << "\n";
+        out << "--- End of Statistics ---\n";
+    }
+};
+
+// ----------------------------------------------------------
+// Stalemate detection by round-state hashing.
+// Once per round the board hashes its economic structure (who owns what,
+// upgrades, who is still playing). A state that stays the same round after
+// round means nobody is gaining or losing ground. Only the previous hash
+// and the length of the current streak are kept.
+// ----------------------------------------------------------
+class StalemateDetector {
+public:
+    StalemateDetector() : lastHash(0), streak(0) {}
+
+    // Returns true once the same state has been seen `threshold` rounds in a row.
+    bool observe(size_t stateHash, int threshold) {
+        if (threshold <= 0) return false;
+        streak = (streak > 0 && stateHash == lastHash) ? streak + 1 : 1;
+        lastHash = stateHash;
+        return streak >= threshold;
+    }
+
+    void reset() {
+        lastHash = 0;
+        streak = 0;
+    }
+
+private:
+    size_t lastHash;
+    int streak;
+};
+
+inline void hashCombine(size_t& seed, size_t value) {
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// ----------------------------------------------------------
+// Task: minimal coroutine type for game logic that may wait on a decision.
+// Tasks start suspended. A Task co_awaited by another Task resumes its
+// caller when it finishes; a top-level Task is driven with start() and is
+// done() once every decision it waited on has been answered.
+// ----------------------------------------------------------
+class Task {
+public:
+    struct promise_type;
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        coroutine_handle<> await_suspend(coroutine_handle<promise_type> h) noexcept {
+            coroutine_handle<> next = h.promise().continuation;
+            return next ? next : noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+
+    struct promise_type {
+        coroutine_handle<> continuation;
+        exception_ptr error;
+
+        Task get_return_object() { return Task(coroutine_handle<promise_type>::from_promise(*this)); }
+        suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { error = current_exception(); }
+    };
+
+    Task() = default;
+    Task(Task&& other) noexcept : handle(exchange(other.handle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = exchange(other.handle, {});
+        }
+        return *this;
+    }
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    bool done() const {
+        return !handle || handle.done();
+    }
+
+    // Run from ordinary code until the task finishes or waits on a decision.
+    void start() {
+        handle.resume();
+        rethrowIfFailed();
     }
+
+    void rethrowIfFailed() const {
+        if (handle && handle.done() && handle.promise().error) rethrow_exception(handle.promise().error);
+    }
+
+    bool await_ready() const noexcept { return false; }
+    coroutine_handle<> await_suspend(coroutine_handle<> caller) noexcept {
+        handle.promise().continuation = caller;
+        return handle;
+    }
+    void await_resume() const {
+        rethrowIfFailed();
+    }
+
+private:
+    explicit Task(coroutine_handle<promise_type> h) : handle(h) {}
+    coroutine_handle<promise_type> handle;
 };
 
 // ----------------------------------------------------------
@@ -218,31 +559,120 @@ public:
     bool isAI;
     unordered_set<string> propertiesOwned;
     unordered_map<string, int> propertyUpgrades;
+    unordered_set<string> mortgagedProperties;
+    int assetValue; // Book value of holdings, kept up to date by Board's ledger operations
+    uint32_t ownedMask;     // Bit i set = owns property with Board::propertyIndex i
+    uint32_t mortgagedMask; // Same layout, for mortgaged properties
     bool bankrupt;
 
     Player(string name, int money = 1500, int position = 0, bool isAI = false)
-        : name(name), money(money), position(position), isAI(isAI), bankrupt(false) {}
-
-    void displayPlayerStats() const {
-        cout << "\n--- Player Stats for " << name << " ---\n";
-        cout << "Money: $" << money << endl;
-        cout << "Position: " << position << endl;
-        cout << "Bankrupt: " << (bankrupt ? "Yes" : "No") << endl;
-        cout << "Properties Owned (" << propertiesOwned.size() << "): ";
+        : name(name), money(money), position(position), isAI(isAI), assetValue(0), ownedMask(0), mortgagedMask(0), bankrupt(false) {}
+
+    int netWorth() const {
+        return money + assetValue;
+    }
+
+    bool isMortgaged(const string& prop) const {
+        return mortgagedProperties.count(prop) > 0;
+    }
+
+    void displayPlayerStats(ostream& out = cout) const {
+        out << "\n--- Player Stats for " << name << " ---\n";
+        out << "Money: $" << money << "\n";
+        out << "Net Worth: $" << netWorth() << "\n";
+        out << "Position: " << position << "\n";
+        out << "Bankrupt: " << (bankrupt ? "Yes" : "No") << "\n";
+        out << "Properties Owned (" << propertiesOwned.size() << "): ";
         for (const auto& prop : propertiesOwned) {
-            cout << prop << " (Upgrades: " << propertyUpgrades.at(prop) << ") ";
+            out << prop << " (Upgrades: " << propertyUpgrades.at(prop) << (isMortgaged(prop) ? ", mortgaged" : "") << ") ";
         }
-        cout << "\n--- End of Player Stats ---\n";
+        out << "\n--- End of Player Stats ---\n";
     }
 
     int totalUpgrades() const {
         return recursiveUpgradeSum(propertyUpgrades, propertyUpgrades.begin(), propertyUpgrades.end());
     }
 
-    bool shouldAIBuyProperty(const string& propertyName, int propertyCost) {
-        if (money > propertyCost * 2) return true;
-        return false;
+    // Completing a colour group is worth spending down to the last dollar for.
+    bool shouldAIBuyProperty(int propertyCost, bool completesMonopoly) {
+        if (money < propertyCost) return false;
+        if (completesMonopoly) return true;
+        // Cash alone undervalues a player holding mortgageable property, so
+        // a wealthy AI keeps buying on a thinner cash cushion.
+        return money > propertyCost * 2 || netWorth() >= propertyCost * 4;
+    }
+};
+
+// ----------------------------------------------------------
+// Decisions
+// Every choice a human player makes is a Decision that game code co_awaits.
+// A DecisionSource either answers on the spot (the console blocks on cin)
+// or parks the waiting coroutine and resumes it once the answer arrives
+// (a network session).
+// ----------------------------------------------------------
+enum class DecisionKind : uint8_t { Buy = 1, Bid = 2, Action = 3, PropertyName = 4 };
+
+struct Decision {
+    DecisionKind kind;
+    const Player* player;
+    string property;   // Property the decision concerns, if any
+    int amount;        // Price or minimum bid, if any
+    string promptText; // Shown to console players
+    int value;         // Answer: 1/0 for Buy, the bid, or the action letter
+    string text;       // Answer for PropertyName
+};
+
+class DecisionSource {
+public:
+    virtual ~DecisionSource() = default;
+
+    // Fill in the answer and return true, or return false to have the
+    // caller suspended until decideLater() resumes it.
+    virtual bool decideNow(Decision& decision) = 0;
+    virtual void decideLater(Decision& decision, coroutine_handle<> waiter) = 0;
+};
+
+struct DecisionAwaiter {
+    DecisionSource& source;
+    Decision decision;
+
+    bool await_ready() { return source.decideNow(decision); }
+    void await_suspend(coroutine_handle<> waiter) { source.decideLater(decision, waiter); }
+    Decision await_resume() { return std::move(decision); }
+};
+
+class ConsoleDecisions : public DecisionSource {
+public:
+    explicit ConsoleDecisions(Renderer& renderer) : renderer(renderer) {}
+
+    bool decideNow(Decision& decision) override {
+        renderer.prompt(decision.promptText);
+        char choice = 0;
+        switch (decision.kind) {
+            case DecisionKind::Buy:
+                cin >> choice;
+                decision.value = (choice == 'y');
+                break;
+            case DecisionKind::Bid:
+                if (!(cin >> decision.value)) decision.value = 0;
+                break;
+            case DecisionKind::Action:
+                cin >> choice;
+                decision.value = choice;
+                break;
+            case DecisionKind::PropertyName:
+                getline(cin >> ws, decision.text);
+                break;
+        }
+        return true;
+    }
+
+    void decideLater(Decision&, coroutine_handle<> waiter) override {
+        waiter.resume();
     }
+
+private:
+    Renderer& renderer;
 };
 
 // ----------------------------------------------------------
@@ -256,12 +686,30 @@ public:
     list<Player> players;
     unordered_map<string, string, PropertyHash> hashedPropertyOwners;
     unordered_map<string, int> rentPrices;
+    unordered_map<string, int> propertyIndex; // Bit position in the ownership masks
+    unordered_map<string, int> propertyGroup; // Index into groupMasks, -1 if not in a colour group
+    vector<string> propertyByIndex;
+    vector<string> groupNames;
+    vector<uint32_t> groupMasks;
     Graph boardGraph;
     Settings gameSettings;
     Statistics gameStats;
+    Renderer renderer;
+    ConsoleDecisions consoleDecisions;
+    DecisionSource* decisions; // Where human players' choices come from; the console unless a server session replaces it
+    LogSink gameLog;
+    StalemateDetector stalemate;
+    mt19937 rng;
+    list<Player>::iterator turnCursor; // Next player to move in playNextTurn()
     bool gameIsOver; // Flag to indicate if the game is ended prematurely
-
-    Board() : gameIsOver(false) {
+    bool stalemateReached;
+
+    // logging = false keeps the board from ever opening its log file.
+    Board(bool render = true, const string& logPath = "game_log.txt", bool logging = true)
+        : renderer(Verbosity::Normal, 50, render), consoleDecisions(renderer), decisions(&consoleDecisions),
+          gameLog(logPath), rng(random_device{}()),
+          turnCursor(players.end()), gameIsOver(false), stalemateReached(false) {
+        gameSettings.enableLogging = logging;
         properties = {
             {1, "Mediterranean Avenue"}, {3, "Baltic Avenue"},
             {5, "Reading Railroad"}, {6, "Oriental Avenue"},
@@ -282,22 +730,78 @@ public:
             hashedPropertyOwners[name] = ""; 
         }
 
+        // Bits are assigned in board order so masks read left-to-right around the board
+        for (int pos = 0; pos < 40; ++pos) {
+            auto it = properties.find(pos);
+            if (it == properties.end()) continue;
+            propertyIndex[it->second] = (int)propertyByIndex.size();
+            propertyGroup[it->second] = -1;
+            propertyByIndex.push_back(it->second);
+        }
+
+        const vector<pair<string, vector<int>>> colourGroups = {
+            {"Brown", {1, 3}}, {"Light Blue", {6, 8, 9}},
+            {"Pink", {11, 13, 14}}, {"Orange", {16, 18, 19}},
+            {"Red", {21, 23, 24}}, {"Yellow", {26, 27, 29}},
+            {"Green", {31, 32, 34}}, {"Dark Blue", {37, 39}}
+        };
+        for (const auto& [groupName, positions] : colourGroups) {
+            uint32_t mask = 0;
+            for (int pos : positions) {
+                mask |= propertyBit(properties[pos]);
+                propertyGroup[properties[pos]] = (int)groupMasks.size();
+            }
+            groupNames.push_back(groupName);
+            groupMasks.push_back(mask);
+        }
+
         for (int i = 0; i < 39; ++i) {
             boardGraph.addEdge(i, (i + 1) % 40);
         }
 
         if (gameSettings.enableLogging) {
-            logAction("Board initialized with " + to_string(properties.size()) + " properties.");
+            gameLog.write("Board initialized with " + to_string(properties.size()) + " properties.");
         }
     }
 
     void addPlayer(const string& playerName, bool isAI = false) {
         players.emplace_back(playerName, gameSettings.startingMoney, 0, isAI);
         if (gameSettings.enableLogging) {
-            logAction("Player added: " + playerName + (isAI ? " (AI)" : ""));
+            gameLog.write("Player added: " + playerName + (isAI ? " (AI)" : ""));
         }
     }
 
+    // ------------------------------------------------------
+    // Colour groups
+    // A player holds a monopoly when (ownedMask & groupMask) == groupMask.
+    // The masks are updated by the ledger functions, so these checks never
+    // look at propertiesOwned.
+    // ------------------------------------------------------
+    uint32_t propertyBit(const string& prop) const {
+        auto it = propertyIndex.find(prop);
+        return it != propertyIndex.end() ? (1u << it->second) : 0;
+    }
+
+    int groupOf(const string& prop) const {
+        auto it = propertyGroup.find(prop);
+        return it != propertyGroup.end() ? it->second : -1;
+    }
+
+    bool hasMonopoly(const Player& player, int group) const {
+        return group >= 0 && (player.ownedMask & groupMasks[group]) == groupMasks[group];
+    }
+
+    bool completesMonopoly(const Player& player, const string& prop) const {
+        int group = groupOf(prop);
+        return group >= 0 && ((player.ownedMask | propertyBit(prop)) & groupMasks[group]) == groupMasks[group];
+    }
+
+    // Upgrades need the whole group, with nothing in it mortgaged.
+    bool canUpgrade(const Player& player, const string& prop) const {
+        int group = groupOf(prop);
+        return hasMonopoly(player, group) && (player.mortgagedMask & groupMasks[group]) == 0;
+    }
+
     int calculateRent(const string& property, int baseRent, int upgrades, int multiplier) {
         if (upgrades == 0) return baseRent;
         return baseRent * multiplier + calculateRent(property, baseRent, upgrades - 1, multiplier);
@@ -312,10 +816,10 @@ public:
     }
 
     int partition(vector<Player>& pvec, int low, int high) {
-        int pivot = pvec[high].money;
+        int pivot = pvec[high].netWorth();
         int i = low - 1;
         for (int j = low; j < high; ++j) {
-            if (pvec[j].money > pivot) {
+            if (pvec[j].netWorth() > pivot) {
                 i++;
                 swap(pvec[i], pvec[j]);
             }
@@ -328,11 +832,14 @@ public:
         TreeNode* root = nullptr;
         for (const auto& player : players) {
             if (!player.bankrupt)
-                insert(root, player.name, player.money);
+                insert(root, player.name, player.netWorth());
         }
-        cout << "\n--- Player Rankings by Wealth ---\n";
-        inOrderTraversal(root);
-        cout << "--- End of Rankings ---\n";
+        if (renderer.wants(Verbosity::Quiet)) {
+            ostringstream out;
+            inOrderTraversal(root, out);
+            renderer.emit(Verbosity::Quiet, "\n--- Player Rankings by Wealth ---\n", out.str(), "--- End of Rankings ---\n");
+        }
+        freeTree(root);
     }
 
     void displaySortedPlayers() {
@@ -341,18 +848,20 @@ public:
             if (!pl.bankrupt) playerVec.push_back(pl);
         }
         quickSortPlayers(playerVec, 0, (int)playerVec.size() - 1);
-        cout << "\n--- Players Sorted by Wealth ---\n";
+        renderer.emit(Verbosity::Quiet, "\n--- Players Sorted by Net Worth ---\n");
         for (const auto& player : playerVec) {
-            cout << player.name << " - Money: $" << player.money << endl;
+            renderer.emit(Verbosity::Quiet, player.name, " - Net Worth: $", player.netWorth(), " (Money: $", player.money, ")\n");
         }
-        cout << "--- End of Sorted Players ---\n";
+        renderer.emit(Verbosity::Quiet, "--- End of Sorted Players ---\n");
     }
 
     void checkAndRemoveBankruptPlayers() {
         for (auto it = players.begin(); it != players.end();) {
             if (it->bankrupt) {
+                releaseProperties(*it);
+                gameStats.recordBankruptcy();
                 if (gameSettings.enableLogging) {
-                    logAction("Player " + it->name + " is bankrupt and removed from the game.");
+                    gameLog.write("Player " + it->name + " is bankrupt and removed from the game.");
                 }
                 it = players.erase(it);
             } else {
@@ -361,8 +870,12 @@ public:
         }
     }
 
-    void auctionProperty(const string& propertyName) {
-        cout << "Auction for " << propertyName << " starting at $10 increment of $5.\n";
+    DecisionAwaiter decide(DecisionKind kind, const Player& player, const string& property, int amount, string promptText) {
+        return DecisionAwaiter{*decisions, Decision{kind, &player, property, amount, std::move(promptText), 0, ""}};
+    }
+
+    Task auctionProperty(string propertyName) {
+        renderer.emit(Verbosity::Normal, "Auction for ", propertyName, " starting at $10 increment of $5.\n");
         int currentBid = 10;
         string highestBidder = "";
         bool someoneBid = false;
@@ -370,17 +883,17 @@ public:
         for (auto& player : players) {
             if (player.bankrupt) continue;
             if (player.isAI) {
-                int decision = rand() % 2; 
+                int decision = completesMonopoly(player, propertyName) ? 1 : uniform_int_distribution<int>(0, 1)(rng);
                 if (decision == 1 && player.money > currentBid) {
                     currentBid += 5;
                     highestBidder = player.name;
                     someoneBid = true;
-                    cout << player.name << " (AI) bids $" << currentBid << "\n";
+                    renderer.emit(Verbosity::Normal, player.name, " (AI) bids $", currentBid, "\n");
                 }
             } else {
-                cout << player.name << ", enter your bid (0 to pass, must be >= " << currentBid << "): ";
-                int bid;
-                cin >> bid;
+                Decision answer = co_await decide(DecisionKind::Bid, player, propertyName, currentBid,
+                    player.name + ", enter your bid (0 to pass, must be >= " + to_string(currentBid) + "): ");
+                int bid = answer.value;
                 if (bid >= currentBid && bid <= player.money) {
                     currentBid = bid;
                     highestBidder = player.name;
@@ -390,59 +903,262 @@ public:
         }
 
         if (someoneBid && !highestBidder.empty()) {
-            cout << highestBidder << " wins the auction for " << propertyName << " at $" << currentBid << "\n";
+            renderer.emit(Verbosity::Normal, highestBidder, " wins the auction for ", propertyName, " at $", currentBid, "\n");
             auto winnerIt = find_if(players.begin(), players.end(), [&](const Player& p){return p.name == highestBidder;});
             if (winnerIt != players.end()) {
-                winnerIt->money -= currentBid;
-                winnerIt->propertiesOwned.insert(propertyName);
-                hashedPropertyOwners[propertyName] = highestBidder;
-                gameStats.recordPropertyBought();
+                acquireProperty(*winnerIt, propertyName, currentBid);
             }
         } else {
-            cout << "No one bid on " << propertyName << ". Remains unowned.\n";
+            renderer.emit(Verbosity::Normal, "No one bid on ", propertyName, ". Remains unowned.\n");
         }
     }
 
-    void mortgageProperty(Player& player) {
-        if (player.propertiesOwned.empty()) {
-            cout << "You have no properties to mortgage.\n";
-            return;
+    // ------------------------------------------------------
+    // Asset ledger
+    // Every change to a player's holdings goes through these functions so
+    // that Player::assetValue (and therefore netWorth()) stays exact without
+    // rescanning propertiesOwned. Book values:
+    //   unmortgaged property = propertyCost
+    //   mortgaged property   = propertyCost - mortgageValue() (the equity)
+    //   each upgrade         = upgradeCost
+    // Mortgaging leaves net worth unchanged; unmortgage interest reduces it.
+    // ------------------------------------------------------
+    int mortgageValue() const {
+        return gameSettings.propertyCost / 2;
+    }
+
+    int unmortgageCost() const {
+        return mortgageValue() + mortgageValue() / 10;
+    }
+
+    void acquireProperty(Player& player, const string& prop, int price) {
+        player.money -= price;
+        player.propertiesOwned.insert(prop);
+        player.propertyUpgrades[prop] = 0;
+        player.assetValue += gameSettings.propertyCost;
+        player.ownedMask |= propertyBit(prop);
+        hashedPropertyOwners[prop] = player.name;
+        gameStats.recordPropertyBought();
+    }
+
+    // Return every holding of a bankrupt player to the bank, unmortgaged and unimproved.
+    void releaseProperties(Player& player) {
+        for (const auto& prop : player.propertiesOwned) {
+            hashedPropertyOwners[prop] = "";
+        }
+        player.propertiesOwned.clear();
+        player.propertyUpgrades.clear();
+        player.mortgagedProperties.clear();
+        player.assetValue = 0;
+        player.ownedMask = 0;
+        player.mortgagedMask = 0;
+    }
+
+    bool mortgage(Player& player, const string& prop) {
+        if (!player.propertiesOwned.count(prop) || player.isMortgaged(prop)) return false;
+        if (player.propertyUpgrades[prop] > 0) return false; // Upgrades must be sold first
+        player.mortgagedProperties.insert(prop);
+        player.mortgagedMask |= propertyBit(prop);
+        player.money += mortgageValue();
+        player.assetValue -= mortgageValue();
+        if (gameSettings.enableLogging) gameLog.write(player.name + " mortgaged " + prop);
+        return true;
+    }
+
+    bool unmortgage(Player& player, const string& prop) {
+        if (!player.isMortgaged(prop) || player.money < unmortgageCost()) return false;
+        player.mortgagedProperties.erase(prop);
+        player.mortgagedMask &= ~propertyBit(prop);
+        player.money -= unmortgageCost();
+        player.assetValue += mortgageValue();
+        if (gameSettings.enableLogging) gameLog.write(player.name + " unmortgaged " + prop);
+        return true;
+    }
+
+    // Upgrades are sold back to the bank at half price.
+    bool sellUpgrade(Player& player, const string& prop) {
+        auto it = player.propertyUpgrades.find(prop);
+        if (it == player.propertyUpgrades.end() || it->second == 0) return false;
+        it->second--;
+        player.money += gameSettings.upgradeCost / 2;
+        player.assetValue -= gameSettings.upgradeCost;
+        if (gameSettings.enableLogging) gameLog.write(player.name + " sold an upgrade on " + prop);
+        return true;
+    }
+
+    int propertyRent(const Player& owner, const string& prop) {
+        if (owner.isMortgaged(prop)) return 0;
+        auto it = owner.propertyUpgrades.find(prop);
+        int upgrades = it != owner.propertyUpgrades.end() ? it->second : 0;
+        int baseRent = hasMonopoly(owner, groupOf(prop)) ? rentPrices[prop] * 2 : rentPrices[prop];
+        return calculateRent(prop, baseRent, upgrades, gameSettings.rentMultiplier);
+    }
+
+    // Cover a negative balance automatically. Upgrades are sold first, most
+    // improved property first; then properties are mortgaged, lowest rent
+    // first, so the player keeps their best earners for as long as possible.
+    // Returns true if the shortfall was covered.
+    bool raiseFunds(Player& player) {
+        if (player.money >= 0) return true;
+
+        vector<string> improved;
+        for (const auto& [prop, upgrades] : player.propertyUpgrades) {
+            if (upgrades > 0) improved.push_back(prop);
+        }
+        sort(improved.begin(), improved.end(), [&](const string& a, const string& b) {
+            return player.propertyUpgrades[a] > player.propertyUpgrades[b];
+        });
+        for (const auto& prop : improved) {
+            while (player.money < 0 && sellUpgrade(player, prop)) {}
+            if (player.money >= 0) break;
+        }
+
+        if (player.money < 0) {
+            vector<pair<int, string>> mortgageable;
+            for (const auto& prop : player.propertiesOwned) {
+                if (!player.isMortgaged(prop)) mortgageable.emplace_back(propertyRent(player, prop), prop);
+            }
+            sort(mortgageable.begin(), mortgageable.end());
+            for (const auto& [rent, prop] : mortgageable) {
+                if (player.money >= 0) break;
+                mortgage(player, prop);
+            }
         }
-        cout << "Enter the name of the property to mortgage: ";
-        string prop;
-        cin >> prop;
+
+        if (player.money < 0) return false;
+        renderer.emit(Verbosity::Normal, player.name, " liquidated assets to cover the shortfall.\n");
+        return true;
+    }
+
+    void declareBankrupt(Player& player, const string& reason) {
+        player.bankrupt = true;
+        releaseProperties(player);
+        renderer.emit(Verbosity::Normal, player.name, " is bankrupt!\n");
+        if (gameSettings.enableLogging) gameLog.write(player.name + " " + reason);
+    }
+
+    bool checkOwned(const Player& player, const string& prop) {
         if (player.propertiesOwned.find(prop) == player.propertiesOwned.end()) {
-            cout << "You do not own that property.\n";
-            return;
+            renderer.emit(Verbosity::Normal, "You do not own that property.\n");
+            return false;
         }
-        player.money += gameSettings.propertyCost / 2;
-        cout << prop << " mortgaged. You gain $" << gameSettings.propertyCost/2 << ".\n";
-        if (gameSettings.enableLogging) {
-            logAction(player.name + " mortgaged " + prop);
+        return true;
+    }
+
+    Task mortgageProperty(Player& player) {
+        if (player.propertiesOwned.size() == player.mortgagedProperties.size()) {
+            renderer.emit(Verbosity::Normal, "You have no properties to mortgage.\n");
+            co_return;
+        }
+        string prop = (co_await decide(DecisionKind::PropertyName, player, "", 0, "Enter the name of the property to mortgage: ")).text;
+        if (!checkOwned(player, prop)) co_return;
+        if (player.isMortgaged(prop)) {
+            renderer.emit(Verbosity::Normal, prop, " is already mortgaged.\n");
+            co_return;
+        }
+        if (!mortgage(player, prop)) {
+            renderer.emit(Verbosity::Normal, "Sell the upgrades on ", prop, " with (x) before mortgaging it.\n");
+            co_return;
         }
+        renderer.emit(Verbosity::Normal, prop, " mortgaged. You gain $", mortgageValue(), ".\n");
     }
 
-    void upgradeProperty(Player& player) {
+    Task unmortgageProperty(Player& player) {
+        if (player.mortgagedProperties.empty()) {
+            renderer.emit(Verbosity::Normal, "You have no mortgaged properties.\n");
+            co_return;
+        }
+        string prop = (co_await decide(DecisionKind::PropertyName, player, "", 0, "Enter the name of the property to unmortgage: ")).text;
+        if (!checkOwned(player, prop)) co_return;
+        if (!player.isMortgaged(prop)) {
+            renderer.emit(Verbosity::Normal, prop, " is not mortgaged.\n");
+            co_return;
+        }
+        if (!unmortgage(player, prop)) {
+            renderer.emit(Verbosity::Normal, "Not enough money to unmortgage (costs $", unmortgageCost(), ").\n");
+            co_return;
+        }
+        renderer.emit(Verbosity::Normal, prop, " unmortgaged for $", unmortgageCost(), ".\n");
+    }
+
+    Task upgradeProperty(Player& player) {
         if (player.propertiesOwned.empty()) {
-            cout << "You have no properties to upgrade.\n";
-            return;
+            renderer.emit(Verbosity::Normal, "You have no properties to upgrade.\n");
+            co_return;
         }
-        cout << "Enter property to upgrade: ";
-        string prop;
-        cin >> prop;
-        if (player.propertiesOwned.find(prop) == player.propertiesOwned.end()) {
-            cout << "You do not own that property.\n";
-            return;
+        string prop = (co_await decide(DecisionKind::PropertyName, player, "", 0, "Enter property to upgrade: ")).text;
+        if (!checkOwned(player, prop)) co_return;
+        if (!hasMonopoly(player, groupOf(prop))) {
+            renderer.emit(Verbosity::Normal, "You need to own the whole colour group to upgrade ", prop, ".\n");
+            co_return;
         }
-        if (player.money < 50) {
-            cout << "Not enough money to upgrade.\n";
-            return;
+        if (!canUpgrade(player, prop)) {
+            renderer.emit(Verbosity::Normal, "You cannot upgrade while a property in the group is mortgaged.\n");
+            co_return;
+        }
+        if (player.money < gameSettings.upgradeCost) {
+            renderer.emit(Verbosity::Normal, "Not enough money to upgrade.\n");
+            co_return;
+        }
+        applyUpgrade(player, prop);
+        renderer.emit(Verbosity::Normal, prop, " upgraded! Total upgrades: ", player.propertyUpgrades[prop], "\n");
+    }
+
+    Task sellUpgradeProperty(Player& player) {
+        if (player.propertiesOwned.empty()) {
+            renderer.emit(Verbosity::Normal, "You have no properties with upgrades to sell.\n");
+            co_return;
+        }
+        string prop = (co_await decide(DecisionKind::PropertyName, player, "", 0, "Enter property to sell an upgrade from: ")).text;
+        if (!checkOwned(player, prop)) co_return;
+        if (!sellUpgrade(player, prop)) {
+            renderer.emit(Verbosity::Normal, prop, " has no upgrades to sell.\n");
+            co_return;
         }
-        player.money -= 50;
+        renderer.emit(Verbosity::Normal, "Sold an upgrade on ", prop, " for $", gameSettings.upgradeCost / 2,
+                      ". Upgrades left: ", player.propertyUpgrades[prop], "\n");
+    }
+
+    void applyUpgrade(Player& player, const string& prop) {
+        player.money -= gameSettings.upgradeCost;
+        player.assetValue += gameSettings.upgradeCost;
         player.propertyUpgrades[prop]++;
-        cout << prop << " upgraded! Total upgrades: " << player.propertyUpgrades[prop] << endl;
         if (gameSettings.enableLogging) {
-            logAction(player.name + " upgraded " + prop);
+            gameLog.write(player.name + " upgraded " + prop);
+        }
+    }
+
+    // AI buys back mortgaged property once it can do so and still keep a
+    // cash reserve, lifting monopolies first so they can be built on again.
+    void aiUnmortgageProperties(Player& player) {
+        if (player.mortgagedProperties.empty()) return;
+        vector<string> mortgaged(player.mortgagedProperties.begin(), player.mortgagedProperties.end());
+        stable_partition(mortgaged.begin(), mortgaged.end(),
+                         [&](const string& prop) { return hasMonopoly(player, groupOf(prop)); });
+        for (const string& prop : mortgaged) {
+            if (player.money - unmortgageCost() < gameSettings.upgradeCost * 4) break;
+            unmortgage(player, prop);
+            renderer.emit(Verbosity::Normal, player.name, " (AI) unmortgaged ", prop, "\n");
+        }
+    }
+
+    // AI builds evenly across each monopoly it holds while it can keep a
+    // cash reserve of a few upgrades.
+    void aiUpgradeProperties(Player& player) {
+        for (int group = 0; group < (int)groupMasks.size(); ++group) {
+            if ((player.ownedMask & groupMasks[group]) != groupMasks[group]) continue;
+            if ((player.mortgagedMask & groupMasks[group]) != 0) continue;
+            while (player.money > gameSettings.upgradeCost * 4) {
+                const string* target = nullptr;
+                for (int i = 0; i < (int)propertyByIndex.size(); ++i) {
+                    if (!(groupMasks[group] & (1u << i))) continue;
+                    const string& prop = propertyByIndex[i];
+                    if (!target || player.propertyUpgrades[prop] < player.propertyUpgrades[*target]) target = &prop;
+                }
+                if (player.propertyUpgrades[*target] >= 4) break;
+                applyUpgrade(player, *target);
+                renderer.emit(Verbosity::Normal, player.name, " (AI) upgraded ", *target, "\n");
+            }
         }
     }
 
@@ -452,21 +1168,29 @@ public:
         for (auto& pl : players) {
             out << pl.name << " " << pl.money << " " << pl.position << " " << pl.isAI << " " << pl.bankrupt << "\n";
             out << pl.propertiesOwned.size() << "\n";
+            // Property names contain spaces, so the name goes last on its line
             for (auto& prop : pl.propertiesOwned) {
-                out << prop << " " << pl.propertyUpgrades[prop] << "\n";
+                out << pl.propertyUpgrades[prop] << " " << pl.isMortgaged(prop) << " " << prop << "\n";
             }
         }
         out.close();
-        cout << "Game saved to " << filename << endl;
+        renderer.emit(Verbosity::Normal, "Game saved to ", filename, "\n");
     }
 
     void loadGame(const string& filename = "savegame.dat") {
         if (!ifstream(filename).is_open()) {
-            cout << "No save file found.\n";
+            renderer.emit(Verbosity::Normal, "No save file found.\n");
             return;
         }
         ifstream in(filename);
         players.clear();
+        // The cursor pointed into the old list; play resumes from the first seat
+        turnCursor = players.end();
+        stalemate.reset();
+        stalemateReached = false;
+        for (auto& [prop, owner] : hashedPropertyOwners) {
+            owner = "";
+        }
         size_t pcount;
         in >> pcount;
         for (size_t i = 0; i < pcount; i++) {
@@ -481,35 +1205,44 @@ public:
             for (size_t j = 0; j < propCount; j++) {
                 string pprop;
                 int pupgrade;
-                in >> pprop >> pupgrade;
+                bool pmortgaged;
+                in >> pupgrade >> pmortgaged;
+                getline(in >> ws, pprop);
                 pl.propertiesOwned.insert(pprop);
                 pl.propertyUpgrades[pprop] = pupgrade;
+                pl.ownedMask |= propertyBit(pprop);
+                pl.assetValue += gameSettings.propertyCost + pupgrade * gameSettings.upgradeCost;
+                if (pmortgaged) {
+                    pl.mortgagedProperties.insert(pprop);
+                    pl.mortgagedMask |= propertyBit(pprop);
+                    pl.assetValue -= mortgageValue();
+                }
                 hashedPropertyOwners[pprop] = pname;
             }
             players.push_back(pl);
         }
         in.close();
-        cout << "Game loaded from " << filename << endl;
+        renderer.emit(Verbosity::Normal, "Game loaded from ", filename, "\n");
     }
 
     void triggerRandomEvent(Player& player) {
         if (!gameSettings.enableRandomEvents) return;
-        int eventType = rand() % 3;
+        int eventType = uniform_int_distribution<int>(0, 2)(rng);
         switch (eventType) {
             case 0:
                 player.money += 50;
-                cout << player.name << " found $50 on the ground!\n";
-                if (gameSettings.enableLogging) logAction(player.name + " found $50.");
+                renderer.emit(Verbosity::Normal, player.name, " found $50 on the ground!\n");
+                if (gameSettings.enableLogging) gameLog.write(player.name + " found $50.");
                 break;
             case 1:
                 if (player.money > 20) {
                     player.money -= 20;
-                    cout << player.name << " had to pay $20 for a fine.\n";
-                    if (gameSettings.enableLogging) logAction(player.name + " paid a $20 fine.");
+                    renderer.emit(Verbosity::Normal, player.name, " had to pay $20 for a fine.\n");
+                    if (gameSettings.enableLogging) gameLog.write(player.name + " paid a $20 fine.");
                 }
                 break;
             case 2:
-                cout << player.name << " experiences no event this turn.\n";
+                renderer.emit(Verbosity::Normal, player.name, " experiences no event this turn.\n");
                 break;
         }
     }
@@ -522,148 +1255,202 @@ public:
         return gameIsOver;
     }
 
-    void handleTurn(Player& player) {
-        if (player.bankrupt) return;
+    Task handleTurn(Player& player) {
+        if (player.bankrupt) co_return;
 
         gameStats.recordTurn(); 
         if (gameSettings.enableLogging) {
-            logAction("Turn start for " + player.name);
+            gameLog.write("Turn start for " + player.name);
         }
 
         triggerRandomEvent(player);
 
         uniform_int_distribution<int> diceRoll(1, 6);
-        mt19937 rng(random_device{}());
         int roll = diceRoll(rng);
 
         player.position = (player.position + roll) % 40;
-        cout << player.name << " rolled " << roll << " and landed on space " << player.position << endl;
+        renderer.emit(Verbosity::Normal, player.name, " rolled ", roll, " and landed on space ", player.position, "\n");
 
         if (properties.count(player.position)) {
             string propertyName = properties[player.position];
-            cout << player.name << " landed on " << propertyName << endl;
+            renderer.emit(Verbosity::Normal, player.name, " landed on ", propertyName, "\n");
 
             if (hashedPropertyOwners[propertyName].empty()) {
-                bool buyDecision = player.isAI ? player.shouldAIBuyProperty(propertyName, gameSettings.propertyCost) : false;
+                bool buyDecision = player.isAI ? player.shouldAIBuyProperty(gameSettings.propertyCost, completesMonopoly(player, propertyName)) : false;
                 if (!player.isAI) {
-                    cout << propertyName << " is available for purchase for $" << gameSettings.propertyCost << ". Buy? (y/n): ";
-                    char choice;
-                    cin >> choice;
-                    if (choice == 'y') buyDecision = true;
+                    Decision answer = co_await decide(DecisionKind::Buy, player, propertyName, gameSettings.propertyCost,
+                        propertyName + " is available for purchase for $" + to_string(gameSettings.propertyCost) + ". Buy? (y/n): ");
+                    buyDecision = answer.value != 0;
                 }
 
                 if (buyDecision && player.money >= gameSettings.propertyCost) {
-                    player.money -= gameSettings.propertyCost;
-                    hashedPropertyOwners[propertyName] = player.name;
-                    player.propertiesOwned.insert(propertyName);
-                    player.propertyUpgrades[propertyName] = 0;
-                    cout << player.name << " bought " << propertyName << endl;
-                    gameStats.recordPropertyBought();
-                    if (gameSettings.enableLogging) logAction(player.name + " bought " + propertyName);
+                    acquireProperty(player, propertyName, gameSettings.propertyCost);
+                    renderer.emit(Verbosity::Normal, player.name, " bought ", propertyName, "\n");
+                    if (gameSettings.enableLogging) gameLog.write(player.name + " bought " + propertyName);
                 } else {
-                    auctionProperty(propertyName);
+                    co_await auctionProperty(propertyName);
                 }
             } else if (hashedPropertyOwners[propertyName] != player.name) {
-                int upgrades = 0;
-                if (player.propertyUpgrades.find(propertyName) != player.propertyUpgrades.end()) {
-                    upgrades = player.propertyUpgrades[propertyName];
+                const string& ownerName = hashedPropertyOwners[propertyName];
+                auto ownerIt = find_if(players.begin(), players.end(), [&](const Player& p){return p.name == ownerName;});
+                if (ownerIt == players.end()) {
+                    // Stale entry for a player no longer at the table; the property goes back to the bank
+                    renderer.emit(Verbosity::Normal, propertyName, " has no active owner. No rent is due.\n");
+                    if (gameSettings.enableLogging) gameLog.write(propertyName + " had no active owner and returned to the bank");
+                    hashedPropertyOwners[propertyName] = "";
+                } else if (ownerIt->isMortgaged(propertyName)) {
+                    renderer.emit(Verbosity::Normal, propertyName, " is mortgaged. No rent is due.\n");
                 } else {
-                    auto ownerIt = find_if(players.begin(), players.end(), [&](const Player& p){return p.name == hashedPropertyOwners[propertyName];});
-                    if (ownerIt != players.end()) {
-                        const Player& owner = *ownerIt;
-                        auto itUp = owner.propertyUpgrades.find(propertyName);
-                        if (itUp != owner.propertyUpgrades.end()) {
-                            upgrades = itUp->second;
-                        }
+                    int rent = propertyRent(*ownerIt, propertyName);
+                    renderer.emit(Verbosity::Normal, player.name, " must pay rent of $", rent, " to ", ownerName, "\n");
+                    player.money -= rent;
+                    // A bankrupt player can only hand over what they managed to raise
+                    int paid = raiseFunds(player) ? rent : rent + player.money;
+                    ownerIt->money += paid;
+                    gameStats.recordRentPaid(paid);
+                    if (gameSettings.enableLogging) gameLog.write(player.name + " paid $" + to_string(paid) + " to " + ownerName);
+                    if (player.money < 0) {
+                        declareBankrupt(player, "went bankrupt!");
                     }
                 }
-                int rent = calculateRent(propertyName, rentPrices[propertyName], upgrades, gameSettings.rentMultiplier);
-                cout << player.name << " must pay rent of $" << rent << " to " << hashedPropertyOwners[propertyName] << endl;
-                player.money -= rent;
-                gameStats.recordRentPaid();
-                if (gameSettings.enableLogging) logAction(player.name + " paid $" + to_string(rent) + " to " + hashedPropertyOwners[propertyName]);
-                auto ownerIt = find_if(players.begin(), players.end(), [&](const Player& p){return p.name == hashedPropertyOwners[propertyName];});
-                if (ownerIt != players.end()) {
-                    Player& owner = const_cast<Player&>(*ownerIt);
-                    owner.money += rent;
-                }
-                if (player.money < 0) {
-                    player.bankrupt = true;
-                    cout << player.name << " is bankrupt!\n";
-                    if (gameSettings.enableLogging) logAction(player.name + " went bankrupt!");
-                }
             } else {
-                cout << propertyName << " is owned by you. No action needed.\n";
+                renderer.emit(Verbosity::Normal, propertyName, " is owned by you. No action needed.\n");
             }
         } else {
-            cout << player.name << " landed on a non-property space.\n";
+            renderer.emit(Verbosity::Normal, player.name, " landed on a non-property space.\n");
         }
 
-        cout << "Showing connections from current position:\n";
-        boardGraph.displayConnectionsFrom(player.position);
+        if (renderer.wants(Verbosity::Verbose)) {
+            ostringstream out;
+            boardGraph.displayConnectionsFrom(player.position, out);
+            renderer.emit(Verbosity::Verbose, "Showing connections from current position:\n", out.str());
+        }
 
         if (!player.isAI && !player.bankrupt) {
-            cout << player.name << ", choose an action: (u)pgrade property, (m)ortgage property, (s)kip, (e)nd game: ";
-            char actionChoice;
-            cin >> actionChoice;
-            switch (actionChoice) {
+            Decision answer = co_await decide(DecisionKind::Action, player, "", 0,
+                player.name + ", choose an action: (u)pgrade property, (m)ortgage property, u(n)mortgage property, sell upgrade (x), (s)kip, (e)nd game: ");
+            switch (answer.value) {
                 case 'u':
-                    upgradeProperty(player);
+                    co_await upgradeProperty(player);
                     break;
                 case 'm':
-                    mortgageProperty(player);
+                    co_await mortgageProperty(player);
+                    break;
+                case 'n':
+                    co_await unmortgageProperty(player);
+                    break;
+                case 'x':
+                    co_await sellUpgradeProperty(player);
                     break;
                 case 's':
-                    cout << "No action taken.\n";
+                    renderer.emit(Verbosity::Normal, "No action taken.\n");
                     break;
                 case 'e':
-                    cout << player.name << " has chosen to end the game.\n";
+                    renderer.emit(Verbosity::Normal, player.name, " has chosen to end the game.\n");
                     endGame(); // Set gameIsOver = true
                     break;
                 default:
-                    cout << "Invalid choice, no action taken.\n";
+                    renderer.emit(Verbosity::Normal, "Invalid choice, no action taken.\n");
                     break;
             }
         }
 
-        if (player.money < 0 && !player.bankrupt) {
-            player.bankrupt = true;
-            cout << player.name << " is bankrupt!\n";
-            if (gameSettings.enableLogging) logAction(player.name + " became bankrupt after post-move actions");
+        if (player.isAI && !player.bankrupt) {
+            aiUnmortgageProperties(player);
+            aiUpgradeProperties(player);
+        }
+
+        if (player.money < 0 && !player.bankrupt && !raiseFunds(player)) {
+            declareBankrupt(player, "became bankrupt after post-move actions");
         }
 
         checkAndRemoveBankruptPlayers();
     }
 
-    void playTurn(Player& player) {
-        handleTurn(player);
+    Task playTurn(Player& player) {
+        co_await handleTurn(player);
+    }
+
+    // Play one turn for the next player in seat order. The cursor is advanced
+    // before the turn, so it stays valid if the player is removed for bankruptcy.
+    Task playNextTurn() {
+        if (players.empty()) co_return;
+        if (turnCursor == players.end()) turnCursor = players.begin();
+        auto current = turnCursor++;
+        co_await playTurn(*current);
+        if (turnCursor == players.end() && stalemate.observe(stateHash(), gameSettings.stalemateRounds)) {
+            stalemateReached = true;
+            renderer.emit(Verbosity::Quiet, "Stalemate: the board has not changed in ", gameSettings.stalemateRounds, " consecutive rounds.\n");
+            if (gameSettings.enableLogging) gameLog.write("Stalemate declared after " + to_string(gameStats.totalTurns) + " turns.");
+        }
+    }
+
+    bool isFinished() const {
+        if (gameIsOver || stalemateReached || players.size() <= 1) return true;
+        return gameSettings.turnLimit > 0 && gameStats.totalTurns >= gameSettings.turnLimit;
+    }
+
+    // Hash of the board's economic structure; money and positions are left
+    // out on purpose since they change every turn even when nothing is decided.
+    size_t stateHash() const {
+        size_t seed = players.size();
+        for (const auto& player : players) {
+            hashCombine(seed, hash<string>{}(player.name));
+            hashCombine(seed, player.ownedMask);
+            hashCombine(seed, player.mortgagedMask);
+            // Summed so the result does not depend on unordered_map iteration order
+            size_t upgrades = 0;
+            for (const auto& [prop, count] : player.propertyUpgrades) {
+                size_t propHash = propertyBit(prop);
+                hashCombine(propHash, (size_t)count);
+                upgrades += propHash;
+            }
+            hashCombine(seed, upgrades);
+        }
+        return seed;
     }
 
-    void displayAllPlayers() const {
-        cout << "\n--- All Players ---\n";
+    void displayAllPlayers() {
+        if (!renderer.wants(Verbosity::Verbose)) return;
+        ostringstream out;
+        out << "\n--- All Players ---\n";
         for (const auto& p : players) {
-            p.displayPlayerStats();
+            p.displayPlayerStats(out);
         }
-        cout << "--- End of All Players ---\n";
+        out << "--- End of All Players ---\n";
+        renderer.emit(Verbosity::Verbose, out.str());
+    }
+
+    void displayBoardGraph() {
+        if (!renderer.wants(Verbosity::Verbose)) return;
+        ostringstream out;
+        boardGraph.displayGraph(out);
+        renderer.emit(Verbosity::Verbose, out.str());
     }
 
-    void displayBoardInfo() const {
-        cout << "\n--- Board Info ---\n";
-        cout << "Number of properties: " << properties.size() << endl;
-        cout << "Properties:\n";
+    void displayBoardInfo() {
+        renderer.emit(Verbosity::Normal, "\n--- Board Info ---\n");
+        renderer.emit(Verbosity::Normal, "Number of properties: ", properties.size(), "\n");
+        renderer.emit(Verbosity::Normal, "Properties:\n");
         for (auto& [pos, pname] : properties) {
-            cout << pos << ": " << pname;
+            renderer.emit(Verbosity::Normal, pos, ": ", pname);
+            if (groupOf(pname) >= 0) {
+                renderer.emit(Verbosity::Normal, " [", groupNames[groupOf(pname)], "]");
+            }
             auto it = hashedPropertyOwners.find(pname);
             if (it != hashedPropertyOwners.end() && !it->second.empty()) {
-                cout << " (Owned by " << it->second << ")";
+                renderer.emit(Verbosity::Normal, " (Owned by ", it->second, ")");
             }
-            cout << "\n";
+            renderer.emit(Verbosity::Normal, "\n");
         }
-        cout << "--- End of Board Info ---\n";
+        renderer.emit(Verbosity::Normal, "--- End of Board Info ---\n");
     }
 
-    void displayGameStats() const {
-        gameStats.displayStatistics();
+    void displayGameStats() {
+        if (!renderer.wants(Verbosity::Quiet)) return;
+        ostringstream out;
+        gameStats.displayStatistics(out);
+        renderer.emit(Verbosity::Quiet, out.str());
     }
 
     void noOpFunctionToMaintainLineCount() {
@@ -680,40 +1467,751 @@ public:
     }
 
     // Print help instructions
-    void printHelp() const {
-        cout << "\n--- HOW TO PLAY INSTRUCTIONS ---\n";
-        cout << "1. Each turn, you roll a die and move forward on the board.\n";
-        cout << "2. If you land on a property:\n";
-        cout << "   - If no one owns it, you can buy it.\n";
-        cout << "   - If another player owns it, you must pay them rent.\n";
-        cout << "3. If you cannot afford rent or expenses, you go bankrupt and are removed from the game.\n";
-        cout << "4. Actions you can take if not bankrupt and not AI:\n";
-        cout << "   (u) Upgrade a property you own (cost $50, increases rent).\n";
-        cout << "   (m) Mortgage a property for quick cash.\n";
-        cout << "   (s) Skip if you don't want to take an action.\n";
-        cout << "   (e) End the game immediately.\n";
-        cout << "5. Random events may occur each turn if enabled.\n";
-        cout << "6. The game ends when one player remains, the turn limit is reached, or if a player chooses to end it.\n";
-        cout << "--- END OF INSTRUCTIONS ---\n\n";
+    void printHelp() {
+        renderer.emit(Verbosity::Normal, "\n--- HOW TO PLAY INSTRUCTIONS ---\n");
+        renderer.emit(Verbosity::Normal, "1. Each turn, you roll a die and move forward on the board.\n");
+        renderer.emit(Verbosity::Normal, "2. If you land on a property:\n");
+        renderer.emit(Verbosity::Normal, "   - If no one owns it, you can buy it.\n");
+        renderer.emit(Verbosity::Normal, "   - If another player owns it, you must pay them rent (doubled if they own the whole colour group).\n");
+        renderer.emit(Verbosity::Normal, "3. If you cannot afford rent, upgrades are sold and properties mortgaged automatically.\n");
+        renderer.emit(Verbosity::Normal, "   If that is still not enough, you go bankrupt and your properties return to the bank.\n");
+        renderer.emit(Verbosity::Normal, "4. Actions you can take if not bankrupt and not AI:\n");
+        renderer.emit(Verbosity::Normal, "   (u) Upgrade a property (cost $50, increases rent). You must own its whole colour group.\n");
+        renderer.emit(Verbosity::Normal, "   (m) Mortgage a property for quick cash (mortgaged properties collect no rent).\n");
+        renderer.emit(Verbosity::Normal, "   (n) Unmortgage a property (mortgage value plus 10% interest).\n");
+        renderer.emit(Verbosity::Normal, "   (x) Sell one upgrade back to the bank for half its cost.\n");
+        renderer.emit(Verbosity::Normal, "   (s) Skip if you don't want to take an action.\n");
+        renderer.emit(Verbosity::Normal, "   (e) End the game immediately.\n");
+        renderer.emit(Verbosity::Normal, "5. Random events may occur each turn if enabled.\n");
+        renderer.emit(Verbosity::Normal, "6. The game ends when one player remains, the turn limit is reached, a stalemate is detected, or if a player chooses to end it.\n");
+        renderer.emit(Verbosity::Normal, "--- END OF INSTRUCTIONS ---\n\n");
+    }
+};
+
+// ----------------------------------------------------------
+// Server mode: wire protocol
+// Frames are fixed-size; the opcode byte determines the length.
+// Integers are little-endian.
+//   HELLO  client -> server  [0x01][u8 bots][u32 seed][u32 turnLimit]             10 bytes
+//   ASK    server -> client  [0x02][u8 kind][u8 property][i32 amount][i32 money]  20 bytes
+//                            [u8 position][u32 ownedMask][u32 mortgagedMask]
+//   ANSWER client -> server  [0x03][i32 value]                                      5 bytes
+//   OVER   server -> client  [0x04][u8 reason][u32 turns][i32 netWorth]           10 bytes
+// kind is a DecisionKind. property is a Board::propertyIndex, or 0xFF for none.
+// Every ASK also carries the client's board state. Bit i of each mask is
+// propertyIndex i. Rolls and rent are not sent, but a client can work them
+// out from the change in position and money between ASKs.
+// ANSWER carries 1/0 for Buy, the bid for Bid, the action letter for Action,
+// and a property index (or -1) for PropertyName.
+// ----------------------------------------------------------
+enum class WireOp : uint8_t { Hello = 0x01, Ask = 0x02, Answer = 0x03, Over = 0x04 };
+enum class OverReason : uint8_t { LastPlayer = 0, TurnLimit = 1, Stalemate = 2, EndedByClient = 3, ClientBankrupt = 4 };
+
+size_t wireFrameSize(uint8_t op) {
+    switch ((WireOp)op) {
+        case WireOp::Hello: return 10;
+        case WireOp::Ask: return 20;
+        case WireOp::Answer: return 5;
+        case WireOp::Over: return 10;
+    }
+    return 0;
+}
+
+void putU32(string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back((char)((value >> (8 * i)) & 0xFF));
+}
+
+uint32_t getU32(const char* in) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) value |= (uint32_t)(unsigned char)in[i] << (8 * i);
+    return value;
+}
+
+// Where the server listens / the load generator connects: a Unix socket
+// path if one is given, otherwise TCP on 127.0.0.1.
+struct Endpoint {
+    string unixPath;
+    int port = 7777;
+};
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+int openListener(const Endpoint& endpoint) {
+    int fd;
+    if (!endpoint.unixPath.empty()) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, endpoint.unixPath.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(endpoint.unixPath.c_str());
+        if (fd < 0 || bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+            perror("bind");
+            return -1;
+        }
+    } else {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int yes = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)endpoint.port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd < 0 || bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+            perror("bind");
+            return -1;
+        }
+    }
+    if (listen(fd, SOMAXCONN) < 0 || !setNonBlocking(fd)) {
+        perror("listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Blocking connect (it is local, so it is quick), then switched to non-blocking.
+int connectTo(const Endpoint& endpoint) {
+    int fd;
+    int rc;
+    if (!endpoint.unixPath.empty()) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, endpoint.unixPath.c_str(), sizeof(addr.sun_path) - 1);
+        rc = fd < 0 ? -1 : connect(fd, (sockaddr*)&addr, sizeof(addr));
+    } else {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)endpoint.port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        rc = fd < 0 ? -1 : connect(fd, (sockaddr*)&addr, sizeof(addr));
+        int yes = 1;
+        if (rc == 0) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    }
+    if (rc < 0 || !setNonBlocking(fd)) {
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Socket plus buffered frames in each direction, shared by both ends.
+struct Connection {
+    int fd = -1;
+    string inbox;
+    size_t inboxPos = 0;
+    string outbox;
+    bool wantsWrite = false;
+
+    // Read whatever is available. Returns false once the peer has gone.
+    bool readAvailable() {
+        char buf[4096];
+        while (true) {
+            ssize_t n = recv(fd, buf, sizeof(buf), 0);
+            if (n > 0) {
+                inbox.append(buf, (size_t)n);
+            } else if (n == 0) {
+                return false;
+            } else {
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            }
+        }
+    }
+
+    // Write as much of the outbox as the socket takes. Returns false on error.
+    bool writeAvailable() {
+        size_t sent = 0;
+        while (sent < outbox.size()) {
+            ssize_t n = send(fd, outbox.data() + sent, outbox.size() - sent, MSG_NOSIGNAL);
+            if (n > 0) {
+                sent += (size_t)n;
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                break;
+            } else {
+                return false;
+            }
+        }
+        outbox.erase(0, sent);
+        return true;
+    }
+
+    // Next complete frame, or nullptr. Returns nullptr and sets `bad` on an unknown opcode.
+    const char* nextFrame(bool& bad) {
+        if (inboxPos >= inbox.size()) return nullptr;
+        size_t size = wireFrameSize((uint8_t)inbox[inboxPos]);
+        if (size == 0) {
+            bad = true;
+            return nullptr;
+        }
+        if (inbox.size() - inboxPos < size) return nullptr;
+        const char* frame = inbox.data() + inboxPos;
+        inboxPos += size;
+        return frame;
+    }
+
+    void compactInbox() {
+        inbox.erase(0, inboxPos);
+        inboxPos = 0;
+    }
+
+    // Keep epoll interest in EPOLLOUT only while there is something left to send.
+    void updateInterest(int epollFd) {
+        bool pending = !outbox.empty();
+        if (pending == wantsWrite) return;
+        wantsWrite = pending;
+        epoll_event ev{};
+        ev.events = pending ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
     }
 };
 
+// ----------------------------------------------------------
+// GameSession: one Board driven by one remote client.
+// The client holds the single human seat; the other seats are AI. The
+// session is the Board's DecisionSource: a human decision becomes an ASK
+// frame, and the waiting turn is parked until the matching ANSWER arrives.
+// ----------------------------------------------------------
+class GameSession : public DecisionSource {
+public:
+    Connection conn;
+    unique_ptr<Board> board;
+    Task turn;
+    Decision* pending;
+    coroutine_handle<> waiter;
+    bool finished;
+    bool queued;
+    long long decisionsAnswered;
+
+    explicit GameSession(int fd) : pending(nullptr), finished(false), queued(false), decisionsAnswered(0) {
+        conn.fd = fd;
+    }
+
+    bool decideNow(Decision&) override {
+        return false;
+    }
+
+    void decideLater(Decision& decision, coroutine_handle<> resumeAt) override {
+        pending = &decision;
+        waiter = resumeAt;
+        auto it = board->propertyIndex.find(decision.property);
+        conn.outbox.push_back((char)WireOp::Ask);
+        conn.outbox.push_back((char)decision.kind);
+        conn.outbox.push_back((char)(it != board->propertyIndex.end() ? it->second : 0xFF));
+        putU32(conn.outbox, (uint32_t)decision.amount);
+        putU32(conn.outbox, (uint32_t)decision.player->money);
+        conn.outbox.push_back((char)decision.player->position);
+        putU32(conn.outbox, decision.player->ownedMask);
+        putU32(conn.outbox, decision.player->mortgagedMask);
+    }
+
+    bool canRun() const {
+        return board && !finished && !pending;
+    }
+
+    // Handle every complete frame in the inbox. Returns false on a protocol error.
+    bool receive() {
+        bool bad = false;
+        while (const char* frame = conn.nextFrame(bad)) {
+            switch ((WireOp)frame[0]) {
+                case WireOp::Hello:
+                    if (board) return false;
+                    start((uint8_t)frame[1], getU32(frame + 2), getU32(frame + 6));
+                    break;
+                case WireOp::Answer:
+                    if (!pending) return false;
+                    answer((int32_t)getU32(frame + 1));
+                    break;
+                default:
+                    return false;
+            }
+        }
+        conn.compactInbox();
+        return !bad;
+    }
+
+    // Play until the client owes a decision, the game ends, or `budget`
+    // turns have run. Returns true if there is more to do right away.
+    bool run(int budget) {
+        while (canRun() && budget-- > 0) {
+            if (board->isFinished() || !clientPlaying()) {
+                finish();
+                break;
+            }
+            turn = board->playNextTurn();
+            turn.start();
+        }
+        return canRun();
+    }
+
+private:
+    void start(uint8_t bots, uint32_t seed, uint32_t turnLimit) {
+        board = make_unique<Board>(false, "game_log.txt", false);
+        board->gameSettings.turnLimit = (int)turnLimit;
+        board->rng.seed(seed);
+        board->decisions = this;
+        board->addPlayer("Client");
+        for (int i = 0; i < max(1, (int)bots); ++i) {
+            board->addPlayer("Bot" + to_string(i + 1), true);
+        }
+    }
+
+    void answer(int32_t value) {
+        if (pending->kind == DecisionKind::PropertyName) {
+            pending->text = (value >= 0 && value < (int)board->propertyByIndex.size()) ? board->propertyByIndex[value] : "";
+        } else {
+            pending->value = value;
+        }
+        pending = nullptr;
+        decisionsAnswered++;
+        exchange(waiter, {}).resume();
+        turn.rethrowIfFailed();
+    }
+
+    const Player* client() const {
+        for (const auto& player : board->players) {
+            if (!player.isAI) return &player;
+        }
+        return nullptr;
+    }
+
+    bool clientPlaying() const {
+        return client() != nullptr;
+    }
+
+    void finish() {
+        OverReason reason = OverReason::LastPlayer;
+        if (!clientPlaying()) reason = OverReason::ClientBankrupt;
+        else if (board->isGameOver()) reason = OverReason::EndedByClient;
+        else if (board->stalemateReached) reason = OverReason::Stalemate;
+        else if (board->players.size() > 1) reason = OverReason::TurnLimit;
+        const Player* me = client();
+        conn.outbox.push_back((char)WireOp::Over);
+        conn.outbox.push_back((char)reason);
+        putU32(conn.outbox, (uint32_t)board->gameStats.totalTurns);
+        putU32(conn.outbox, (uint32_t)(me ? me->netWorth() : 0));
+        finished = true;
+    }
+};
+
+// ----------------------------------------------------------
+// GameServer: single-threaded epoll loop multiplexing GameSessions.
+// Sessions with AI turns to play sit in a run queue and get a slice of
+// turns per loop iteration, so a long run of bot turns never starves
+// the sockets.
+// ----------------------------------------------------------
+class GameServer {
+public:
+    GameServer(const Endpoint& endpoint, long long maxSessions)
+        : endpoint(endpoint), maxSessions(maxSessions), listenFd(-1), epollFd(-1), listening(false),
+          sessionsCompleted(0), decisionsAnswered(0) {}
+
+    int run() {
+        listenFd = openListener(endpoint);
+        epollFd = epoll_create1(0);
+        if (listenFd < 0 || epollFd < 0) return 1;
+        watch(listenFd);
+        listening = true;
+        cout << "Server listening on " << (endpoint.unixPath.empty() ? "127.0.0.1:" + to_string(endpoint.port) : endpoint.unixPath) << endl;
+
+        auto started = chrono::steady_clock::now();
+        vector<epoll_event> events(1024);
+        while (maxSessions == 0 || sessionsCompleted < maxSessions) {
+            int n = epoll_wait(epollFd, events.data(), (int)events.size(), runQueue.empty() ? -1 : 0);
+            if (n < 0 && errno != EINTR) {
+                perror("epoll_wait");
+                break;
+            }
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    acceptAll();
+                    continue;
+                }
+                auto it = sessions.find(fd);
+                if (it == sessions.end()) continue;
+                GameSession& session = *it->second;
+                bool ok = true;
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    try {
+                        ok = session.conn.readAvailable() && session.receive();
+                    } catch (const exception& e) {
+                        cerr << "Session error: " << e.what() << "\n";
+                        ok = false;
+                    }
+                }
+                service(session, ok);
+            }
+
+            // One slice for every session that was runnable at the start of this pass
+            for (size_t count = runQueue.size(); count > 0; --count) {
+                int fd = runQueue.front();
+                runQueue.pop_front();
+                auto it = sessions.find(fd);
+                if (it == sessions.end()) continue;
+                bool ok = true;
+                it->second->queued = false;
+                try {
+                    it->second->run(turnSlice);
+                } catch (const exception& e) {
+                    cerr << "Session error: " << e.what() << "\n";
+                    ok = false;
+                }
+                service(*it->second, ok);
+            }
+        }
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        cout << "Server done: " << sessionsCompleted << " sessions, " << decisionsAnswered << " decisions in "
+             << fixed << setprecision(2) << seconds << "s\n";
+        for (auto& [fd, session] : sessions) close(fd);
+        close(epollFd);
+        close(listenFd);
+        if (!endpoint.unixPath.empty()) unlink(endpoint.unixPath.c_str());
+        return 0;
+    }
+
+private:
+    static constexpr int turnSlice = 64;
+
+    Endpoint endpoint;
+    long long maxSessions;
+    int listenFd;
+    int epollFd;
+    bool listening;
+    unordered_map<int, unique_ptr<GameSession>> sessions;
+    deque<int> runQueue;
+    long long sessionsCompleted;
+    long long decisionsAnswered;
+
+    void watch(int fd) {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    void acceptAll() {
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) continue;
+                // Out of descriptors: the pending connection stays queued and the
+                // level-triggered listener would wake us forever, so stop watching
+                // it until a session closes and frees one.
+                if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                    epoll_ctl(epollFd, EPOLL_CTL_DEL, listenFd, nullptr);
+                    listening = false;
+                }
+                return;
+            }
+            int yes = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+            sessions[fd] = make_unique<GameSession>(fd);
+            watch(fd);
+        }
+    }
+
+    // After any activity: queue the session if it can play on, flush its
+    // output, and retire it once the game is over and everything is sent.
+    void service(GameSession& session, bool ok) {
+        if (ok && session.canRun() && !session.queued) {
+            session.queued = true;
+            runQueue.push_back(session.conn.fd);
+        }
+        ok = ok && session.conn.writeAvailable();
+        if (ok && !(session.finished && session.conn.outbox.empty())) {
+            session.conn.updateInterest(epollFd);
+            return;
+        }
+        if (session.finished) sessionsCompleted++;
+        decisionsAnswered += session.decisionsAnswered;
+        int fd = session.conn.fd;
+        close(fd);
+        sessions.erase(fd);
+        if (!listening) {
+            watch(listenFd);
+            listening = true;
+        }
+    }
+};
+
+// ----------------------------------------------------------
+// LoadGenerator: local client that keeps `concurrency` sessions open
+// against a running server until `totalSessions` have finished, answering
+// every ASK with a simple bot policy, then reports throughput.
+// ----------------------------------------------------------
+class LoadGenerator {
+public:
+    LoadGenerator(const Endpoint& endpoint, long long totalSessions, int concurrency, int turnLimit)
+        : endpoint(endpoint), totalSessions(totalSessions), concurrency(concurrency), turnLimit(turnLimit),
+          epollFd(-1), sessionsStarted(0), sessionsCompleted(0), decisions(0), turns(0), rng(12345) {}
+
+    int run() {
+        epollFd = epoll_create1(0);
+        auto started = chrono::steady_clock::now();
+        while (sessionsStarted < totalSessions && (long long)clients.size() < concurrency) {
+            if (!openSession()) return 1;
+        }
+
+        vector<epoll_event> events(1024);
+        while (!clients.empty()) {
+            int n = epoll_wait(epollFd, events.data(), (int)events.size(), -1);
+            if (n < 0 && errno != EINTR) {
+                perror("epoll_wait");
+                break;
+            }
+            for (int i = 0; i < n; ++i) {
+                auto it = clients.find(events[i].data.fd);
+                if (it == clients.end()) continue;
+                Connection& conn = it->second;
+                bool open = conn.readAvailable();
+                bool over = false;
+                bool bad = false;
+                while (const char* frame = conn.nextFrame(bad)) {
+                    if ((WireOp)frame[0] == WireOp::Ask) {
+                        conn.outbox.push_back((char)WireOp::Answer);
+                        putU32(conn.outbox, (uint32_t)respond((DecisionKind)frame[1], (int32_t)getU32(frame + 3), (int32_t)getU32(frame + 7), getU32(frame + 12)));
+                        decisions++;
+                    } else if ((WireOp)frame[0] == WireOp::Over) {
+                        turns += getU32(frame + 2);
+                        over = true;
+                    }
+                }
+                conn.compactInbox();
+                if (!over && open && !bad && conn.writeAvailable()) {
+                    conn.updateInterest(epollFd);
+                    continue;
+                }
+                if (over) sessionsCompleted++;
+                close(conn.fd);
+                clients.erase(it);
+                if (sessionsStarted < totalSessions && !openSession()) break;
+            }
+        }
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        cout << fixed << setprecision(2)
+             << "Load: " << sessionsCompleted << "/" << totalSessions << " sessions, " << decisions << " decisions, "
+             << turns << " turns in " << seconds << "s\n"
+             << "      " << sessionsCompleted / seconds << " sessions/s, " << decisions / seconds << " decisions/s, "
+             << turns / seconds << " turns/s\n";
+        close(epollFd);
+        return sessionsCompleted == totalSessions ? 0 : 1;
+    }
+
+private:
+    Endpoint endpoint;
+    long long totalSessions;
+    int concurrency;
+    int turnLimit;
+    int epollFd;
+    unordered_map<int, Connection> clients;
+    long long sessionsStarted;
+    long long sessionsCompleted;
+    long long decisions;
+    long long turns;
+    mt19937 rng;
+
+    bool openSession() {
+        int fd = connectTo(endpoint);
+        if (fd < 0) {
+            perror("connect");
+            return false;
+        }
+        Connection& conn = clients[fd];
+        conn.fd = fd;
+        conn.outbox.push_back((char)WireOp::Hello);
+        conn.outbox.push_back((char)3);
+        putU32(conn.outbox, (uint32_t)rng());
+        putU32(conn.outbox, (uint32_t)turnLimit);
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        conn.writeAvailable();
+        conn.updateInterest(epollFd);
+        sessionsStarted++;
+        return true;
+    }
+
+    // Buy when comfortably affordable, bid the minimum now and then, and
+    // mostly skip the action menu, trying an upgrade on a random owned
+    // property occasionally so every decision kind gets exercised.
+    int32_t respond(DecisionKind kind, int32_t amount, int32_t money, uint32_t ownedMask) {
+        switch (kind) {
+            case DecisionKind::Buy:
+                return money >= amount * 2 ? 1 : 0;
+            case DecisionKind::Bid:
+                return (money > amount * 4 && rng() % 2) ? amount : 0;
+            case DecisionKind::Action:
+                return rng() % 10 == 0 ? 'u' : 's';
+            case DecisionKind::PropertyName: {
+                vector<int32_t> owned;
+                for (int32_t i = 0; i < 32; ++i) {
+                    if (ownedMask & (1u << i)) owned.push_back(i);
+                }
+                return owned.empty() ? -1 : owned[rng() % owned.size()];
+            }
+        }
+        return 0;
+    }
+};
+
+// ----------------------------------------------------------
+// Soak check
+// The first half of the turns is one AI-only game that cannot end:
+// bankroll too deep to go bankrupt, stalemate threshold out of reach.
+// The second half is back-to-back ordinary games with no turn limit.
+// Rendering is off and the log is small and rotating. Resident memory is
+// sampled throughout. The check fails if RSS grows by more than the
+// tolerance after the first 10% of turns.
+// ----------------------------------------------------------
+long residentKilobytes() {
+    ifstream statm("/proc/self/statm");
+    long sizePages = 0, residentPages = 0;
+    statm >> sizePages >> residentPages;
+    return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+int runSoakTest(long long targetTurns) {
+    const long toleranceKb = 1024;
+    const long long minimumTurns = 1000; // Below this the warm-up sample would be meaningless
+    targetTurns = max(targetTurns, minimumTurns);
+    const long long warmupTurns = targetTurns / 10;
+    const long long sampleEvery = max(1LL, targetTurns / 100);
+    long long turns = 0;
+    long long singleGameTurns = 0;
+    int games = 0;
+    long baselineKb = 0;
+    long peakKb = 0;
+
+    auto playOne = [&](Board& board) {
+        board.playNextTurn().start();
+        turns++;
+        if (turns == warmupTurns) {
+            baselineKb = residentKilobytes();
+            peakKb = baselineKb;
+        } else if (turns > warmupTurns && (turns % sampleEvery == 0 || turns == targetTurns)) {
+            peakKb = max(peakKb, residentKilobytes());
+        }
+    };
+
+    {
+        Board board(false, "soak_log.txt");
+        board.gameLog.maxBytes = 256 * 1024;
+        board.gameSettings.turnLimit = 0;
+        board.gameSettings.startingMoney = 1000000000;
+        board.gameSettings.stalemateRounds = numeric_limits<int>::max();
+        for (int i = 0; i < 4; ++i) {
+            board.addPlayer("Bot" + to_string(i + 1), true);
+        }
+        while (!board.isFinished() && turns < targetTurns / 2) {
+            playOne(board);
+        }
+        singleGameTurns = turns;
+        games++;
+    }
+
+    while (turns < targetTurns) {
+        Board board(false, "soak_log.txt");
+        board.gameLog.maxBytes = 256 * 1024;
+        board.gameSettings.turnLimit = 0;
+        for (int i = 0; i < 4; ++i) {
+            board.addPlayer("Bot" + to_string(i + 1), true);
+        }
+        while (!board.isFinished() && turns < targetTurns) {
+            playOne(board);
+        }
+        games++;
+    }
+
+    long growthKb = peakKb - baselineKb;
+    cout << "Soak: " << turns << " turns over " << games << " games (first game " << singleGameTurns
+         << " turns), RSS baseline " << baselineKb << " KB, peak " << peakKb << " KB, growth " << growthKb << " KB\n";
+    if (growthKb > toleranceKb) {
+        cout << "Soak FAILED: RSS grew by more than " << toleranceKb << " KB\n";
+        return 1;
+    }
+    cout << "Soak passed.\n";
+    return 0;
+}
+
 // ----------------------------------------------------------
 // Main function
 // ----------------------------------------------------------
-int main() {
-    srand((unsigned)time(nullptr));
+// Usage: main [--quiet | --verbose] [--refresh-ms N] [--no-render]
+//             [--long | --turns N] [--soak [turns]]
+//        main --server [--port N | --unix PATH] [--max-sessions N]
+//        main --loadgen [--port N | --unix PATH] [--sessions N] [--concurrency N] [--turns N]
+// --no-render detaches the renderer; only prompts for human players are shown.
+// --long removes the turn limit; the game runs until one player remains or a stalemate.
+// --soak runs the bounded-memory check (default one million turns) and exits.
+// --server hosts sessions until --max-sessions have finished (0 = forever);
+// --loadgen drives a running server and reports sessions and decisions per second.
+int main(int argc, char* argv[]) {
+    Endpoint endpoint;
+    string mode;
+    long long sessionCount = 0;
+    int concurrency = 256;
+    int sessionTurns = 200;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--soak") {
+            long long turns = (i + 1 < argc) ? atoll(argv[i + 1]) : 0;
+            return runSoakTest(turns > 0 ? turns : 1000000);
+        } else if (arg == "--server" || arg == "--loadgen") {
+            mode = arg;
+        } else if (arg == "--port" && i + 1 < argc) {
+            endpoint.port = atoi(argv[++i]);
+        } else if (arg == "--unix" && i + 1 < argc) {
+            endpoint.unixPath = argv[++i];
+        } else if ((arg == "--max-sessions" || arg == "--sessions") && i + 1 < argc) {
+            sessionCount = atoll(argv[++i]);
+        } else if (arg == "--concurrency" && i + 1 < argc) {
+            concurrency = max(1, atoi(argv[++i]));
+        } else if (arg == "--turns" && i + 1 < argc) {
+            sessionTurns = atoi(argv[i + 1]); // Not consumed: also read below for console games
+        }
+    }
+    if (mode == "--server") {
+        return GameServer(endpoint, sessionCount).run();
+    }
+    if (mode == "--loadgen") {
+        return LoadGenerator(endpoint, sessionCount > 0 ? sessionCount : 10000, concurrency, sessionTurns).run();
+    }
 
     Board gameBoard;
 
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--long") {
+            gameBoard.gameSettings.turnLimit = 0;
+        } else if (arg == "--turns" && i + 1 < argc) {
+            gameBoard.gameSettings.turnLimit = atoi(argv[++i]);
+        } else if (arg == "--quiet") {
+            gameBoard.renderer.verbosity = Verbosity::Quiet;
+        } else if (arg == "--verbose") {
+            gameBoard.renderer.verbosity = Verbosity::Verbose;
+        } else if (arg == "--refresh-ms" && i + 1 < argc) {
+            gameBoard.renderer.setRefreshRate(atoi(argv[++i]));
+        } else if (arg == "--no-render") {
+            gameBoard.renderer.detach();
+        }
+    }
+
     int numPlayers;
-    cout << "Welcome to Monopoly Simplified Extended Version!\n";
-    cout << "Enter number of players: ";
+    gameBoard.renderer.emit(Verbosity::Quiet, "Welcome to Monopoly Simplified Extended Version!\n");
+    gameBoard.renderer.prompt("Enter number of players: ");
     cin >> numPlayers;
 
     for (int i = 0; i < numPlayers; ++i) {
         string playerName;
-        cout << "Enter name for player " << i + 1 << ": ";
+        gameBoard.renderer.prompt("Enter name for player ", i + 1, ": ");
         cin >> playerName;
         bool isAI = (i % 2 == 1);
         gameBoard.addPlayer(playerName, isAI);
@@ -727,34 +2225,25 @@ int main() {
     gameBoard.noOpFunctionToMaintainLineCount();
     gameBoard.anotherNoOpFunction();
 
-    int turnLimit = 50;
-    auto playerIt = gameBoard.players.begin();
-    for (int t = 0; t < turnLimit && !gameBoard.players.empty(); t++) {
-        if (playerIt == gameBoard.players.end()) {
-            playerIt = gameBoard.players.begin();
-        }
-
-        if (!playerIt->bankrupt) {
-            gameBoard.playTurn(*playerIt);
-        }
-
-        // Check if the game was ended by a player's action
-        if (gameBoard.isGameOver()) {
-            cout << "The game has been ended prematurely by a player's choice.\n";
-            break;
-        }
+    while (!gameBoard.isFinished()) {
+        // The console answers every decision on the spot, so each turn runs to completion here
+        gameBoard.playNextTurn().start();
+    }
 
-        ++playerIt;
+    // Check if the game was ended by a player's action
+    if (gameBoard.isGameOver()) {
+        gameBoard.renderer.emit(Verbosity::Quiet, "The game has been ended prematurely by a player's choice.\n");
     }
 
     gameBoard.displayPlayerRankings();
     gameBoard.displaySortedPlayers();
-    gameBoard.boardGraph.displayGraph();
+    gameBoard.displayBoardGraph();
     gameBoard.displayGameStats();
     gameBoard.displayAllPlayers();
 
     gameBoard.saveGame();
 
-    cout << "Game Over!\n";
+    gameBoard.renderer.emit(Verbosity::Quiet, "Game Over!\n");
+    gameBoard.renderer.detach();
     return 0;
 }